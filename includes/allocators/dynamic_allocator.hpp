@@ -2,6 +2,7 @@
 
 #include <list>
 #include <memory>
+#include <memory_resource>
 
 namespace allocators {
 
@@ -25,6 +26,8 @@ private:
     std::size_t size;
   };
   friend bool operator==(const BlockData &a, const BlockData &b);
+  void *TakeFromFreeBlock(std::list<BlockData>::iterator it, std::size_t size,
+                          std::size_t alignment);
   std::list<BlockData> occupied_blocks_;
   std::list<BlockData> free_blocks_;
   std::list<BlockData> all_blocks_;
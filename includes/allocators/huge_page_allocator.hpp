@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <memory_resource>
+
+namespace allocators {
+
+// Serves requests of at least threshold bytes from 2 MB aligned mmap
+// regions. Smaller requests go to the upstream resource.
+class HugePageMemoryResource : public std::pmr::memory_resource {
+public:
+  static constexpr std::size_t kHugePageSize = 2 * 1024 * 1024;
+  enum class PageMode {
+    // Explicit hugetlb pages when reserved, otherwise kTransparent.
+    kHugeTlb,
+    // Normal pages advised with MADV_HUGEPAGE.
+    kTransparent,
+    // Normal pages advised with MADV_NOHUGEPAGE, a baseline for
+    // measurements.
+    kNormal,
+  };
+
+  explicit HugePageMemoryResource(
+      std::pmr::memory_resource *upstream = std::pmr::get_default_resource(),
+      std::size_t threshold = kHugePageSize,
+      PageMode mode = PageMode::kHugeTlb) noexcept;
+  HugePageMemoryResource(const HugePageMemoryResource &resource) = delete;
+  HugePageMemoryResource(HugePageMemoryResource &&resource) noexcept;
+  ~HugePageMemoryResource() override;
+  std::size_t Threshold() const noexcept;
+  // Bytes currently mapped for large requests, rounded to huge pages.
+  // Includes regions that failed to unmap on deallocation.
+  std::size_t MappedBytes() const noexcept;
+  // How many of the current mappings are backed by hugetlb pages.
+  std::size_t HugeTlbMappings() const noexcept;
+
+private:
+  void *do_allocate(std::size_t size, std::size_t alignment) override final;
+  void do_deallocate(void *ptr, std::size_t size,
+                     std::size_t alignment) override final;
+  bool do_is_equal(
+      const std::pmr::memory_resource &resource) const noexcept override final;
+  bool IsLarge(std::size_t size, std::size_t alignment) const noexcept;
+
+private:
+  struct Mapping {
+    void *data;
+    std::size_t size;
+    bool hugetlb;
+  };
+  std::pmr::memory_resource *upstream_;
+  std::size_t threshold_;
+  PageMode mode_;
+  std::list<Mapping> mappings_;
+};
+} // namespace allocators
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <stdexcept>
+
+namespace flat {
+class KeyNotFound : public std::out_of_range {
+public:
+  KeyNotFound()
+      : std::out_of_range("you tried to access a key that is not in the map") {
+  }
+};
+} // namespace flat
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <utility>
+
+#include <flat/search.hpp>
+#include <vector/vector.hpp>
+
+namespace flat {
+// Sorted map with keys and values in separate vector::Vector buffers, so
+// lookups only walk the densely packed keys.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename Allocator = std::pmr::polymorphic_allocator<std::pair<K, V>>>
+class FlatMap {
+private:
+  using KeyAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<K>;
+  using ValueAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<V>;
+  using OrderAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<std::size_t>;
+
+public:
+  using KeyVector = vector::Vector<K, KeyAllocator>;
+  using ValueVector = vector::Vector<V, ValueAllocator>;
+
+  explicit FlatMap(const Allocator &allocator = Allocator(),
+                   const Compare &comp = Compare());
+  // Sorts once, for duplicate keys the first occurrence is kept.
+  template <typename InputIt>
+  FlatMap(InputIt first, InputIt last, const Allocator &allocator = Allocator(),
+          const Compare &comp = Compare());
+  FlatMap(const std::initializer_list<std::pair<K, V>> &list,
+          const Allocator &allocator = Allocator(),
+          const Compare &comp = Compare());
+  std::size_t Size() const noexcept;
+  bool Contains(const K &key) const;
+  V *Find(const K &key);
+  const V *Find(const K &key) const;
+  V &At(const K &key);
+  const V &At(const K &key) const;
+  V &operator[](const K &key)
+    requires std::is_default_constructible_v<V>;
+  bool Insert(const K &key, const V &value);
+  bool Insert(K &&key, V &&value);
+  // Sorts the new pairs and merges them in one pass instead of shifting
+  // the tail once per pair. Keys already in the map keep their values.
+  template <typename InputIt> void InsertRange(InputIt first, InputIt last);
+  bool Erase(const K &key);
+  const KeyVector &Keys() const noexcept;
+  const ValueVector &Values() const noexcept;
+  // Speeds up lookups on large read-mostly maps, dropped on mutation.
+  void BuildEytzingerIndex();
+
+private:
+  std::size_t LowerBoundIndex(const K &key) const;
+  std::size_t FindIndex(const K &key) const;
+  template <typename U, typename W> bool InsertInternal(U &&key, W &&value);
+  void SortUnique(KeyVector &keys, ValueVector &values) const;
+
+private:
+  [[no_unique_address]] Compare comp_;
+  KeyVector keys_;
+  ValueVector values_;
+  EytzingerIndex<K, KeyAllocator> index_;
+};
+}; // namespace flat
+#include <flat/flat_map.ipp>
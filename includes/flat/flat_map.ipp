@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include <flat/flat_exceptions.hpp>
+#include <flat/flat_map.hpp>
+
+namespace flat {
+template <typename K, typename V, typename Compare, typename Allocator>
+FlatMap<K, V, Compare, Allocator>::FlatMap(const Allocator &allocator,
+                                           const Compare &comp)
+    : comp_(comp), keys_(KeyAllocator(allocator)),
+      values_(ValueAllocator(allocator)), index_(KeyAllocator(allocator)) {}
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+FlatMap<K, V, Compare, Allocator>::FlatMap(InputIt first, InputIt last,
+                                           const Allocator &allocator,
+                                           const Compare &comp)
+    : FlatMap(allocator, comp) {
+  for (; first != last; ++first) {
+    keys_.PushBack(first->first);
+    values_.PushBack(first->second);
+  }
+  SortUnique(keys_, values_);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+FlatMap<K, V, Compare, Allocator>::FlatMap(
+    const std::initializer_list<std::pair<K, V>> &list,
+    const Allocator &allocator, const Compare &comp)
+    : FlatMap(list.begin(), list.end(), allocator, comp) {}
+template <typename K, typename V, typename Compare, typename Allocator>
+void FlatMap<K, V, Compare, Allocator>::SortUnique(KeyVector &keys,
+                                                   ValueVector &values) const {
+  // Sorting positions instead of pairs keeps the first of equal keys
+  // without a stable sort and moves every pair only once.
+  const KeyVector &unsorted = keys;
+  vector::Vector<std::size_t, OrderAllocator> order(
+      OrderAllocator(keys.GetAllocator()));
+  order.Reserve(keys.Size());
+  for (std::size_t i = 0; i < keys.Size(); ++i) {
+    order.PushBack(i);
+  }
+  std::sort(order.Begin(), order.End(),
+            [this, &unsorted](std::size_t a, std::size_t b) {
+              if (comp_(unsorted[a], unsorted[b])) {
+                return true;
+              }
+              if (comp_(unsorted[b], unsorted[a])) {
+                return false;
+              }
+              return a < b;
+            });
+  KeyVector sorted_keys(keys.GetAllocator());
+  ValueVector sorted_values(values.GetAllocator());
+  sorted_keys.Reserve(keys.Size());
+  sorted_values.Reserve(keys.Size());
+  for (std::size_t i = 0; i < order.Size(); ++i) {
+    std::size_t idx = order[i];
+    if (sorted_keys.Size() != 0 && !comp_(sorted_keys.Back(), unsorted[idx])) {
+      continue;
+    }
+    sorted_keys.PushBack(std::move(keys[idx]));
+    sorted_values.PushBack(std::move(values[idx]));
+  }
+  keys.Swap(sorted_keys);
+  values.Swap(sorted_values);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+std::size_t FlatMap<K, V, Compare, Allocator>::Size() const noexcept {
+  return keys_.Size();
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+std::size_t
+FlatMap<K, V, Compare, Allocator>::LowerBoundIndex(const K &key) const {
+  if (index_.Built()) {
+    return index_.LowerBound(key, comp_);
+  }
+  const K *keys = keys_.Size() == 0 ? nullptr : &keys_[0];
+  return flat::LowerBound(keys, keys_.Size(), key, comp_);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+std::size_t FlatMap<K, V, Compare, Allocator>::FindIndex(const K &key) const {
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx != keys_.Size() && !comp_(key, keys_[idx])) {
+    return idx;
+  }
+  return keys_.Size();
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+bool FlatMap<K, V, Compare, Allocator>::Contains(const K &key) const {
+  return FindIndex(key) != keys_.Size();
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+V *FlatMap<K, V, Compare, Allocator>::Find(const K &key) {
+  std::size_t idx = FindIndex(key);
+  return idx == keys_.Size() ? nullptr : &values_[idx];
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+const V *FlatMap<K, V, Compare, Allocator>::Find(const K &key) const {
+  std::size_t idx = FindIndex(key);
+  return idx == keys_.Size() ? nullptr : &values_[idx];
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+V &FlatMap<K, V, Compare, Allocator>::At(const K &key) {
+  V *value = Find(key);
+  if (value == nullptr) {
+    throw flat::KeyNotFound();
+  }
+  return *value;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+const V &FlatMap<K, V, Compare, Allocator>::At(const K &key) const {
+  const V *value = Find(key);
+  if (value == nullptr) {
+    throw flat::KeyNotFound();
+  }
+  return *value;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+V &FlatMap<K, V, Compare, Allocator>::operator[](const K &key)
+  requires std::is_default_constructible_v<V>
+{
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx == keys_.Size() || comp_(key, keys_[idx])) {
+    index_.Clear();
+    keys_.Insert(idx, key);
+    try {
+      values_.Insert(idx, V());
+    } catch (...) {
+      keys_.Delete(idx);
+      throw;
+    }
+  }
+  return values_[idx];
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+bool FlatMap<K, V, Compare, Allocator>::Insert(const K &key, const V &value) {
+  return InsertInternal(key, value);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+bool FlatMap<K, V, Compare, Allocator>::Insert(K &&key, V &&value) {
+  return InsertInternal(std::move(key), std::move(value));
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename U, typename W>
+bool FlatMap<K, V, Compare, Allocator>::InsertInternal(U &&key, W &&value) {
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx != keys_.Size() && !comp_(key, keys_[idx])) {
+    return false;
+  }
+  index_.Clear();
+  keys_.Insert(idx, std::forward<U>(key));
+  // Vector::Insert leaves values_ untouched when it throws, so dropping
+  // the key restores the map.
+  try {
+    values_.Insert(idx, std::forward<W>(value));
+  } catch (...) {
+    keys_.Delete(idx);
+    throw;
+  }
+  return true;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+template <typename InputIt>
+void FlatMap<K, V, Compare, Allocator>::InsertRange(InputIt first,
+                                                    InputIt last) {
+  KeyVector added_keys(keys_.GetAllocator());
+  ValueVector added_values(values_.GetAllocator());
+  for (; first != last; ++first) {
+    added_keys.PushBack(first->first);
+    added_values.PushBack(first->second);
+  }
+  if (added_keys.Size() == 0) {
+    return;
+  }
+  SortUnique(added_keys, added_values);
+  index_.Clear();
+  KeyVector merged_keys(keys_.GetAllocator());
+  ValueVector merged_values(values_.GetAllocator());
+  merged_keys.Reserve(keys_.Size() + added_keys.Size());
+  merged_values.Reserve(keys_.Size() + added_keys.Size());
+  // Moving a key and then failing to copy its value would corrupt the live
+  // map, so existing pairs are only moved when neither move can throw.
+  auto take = [](auto &element) -> decltype(auto) {
+    if constexpr (std::is_nothrow_move_constructible_v<K> &&
+                  std::is_nothrow_move_constructible_v<V>) {
+      return std::move(element);
+    } else {
+      return std::as_const(element);
+    }
+  };
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < keys_.Size() && j < added_keys.Size()) {
+    if (comp_(added_keys[j], keys_[i])) {
+      merged_keys.PushBack(std::move(added_keys[j]));
+      merged_values.PushBack(std::move(added_values[j]));
+      ++j;
+    } else {
+      if (!comp_(keys_[i], added_keys[j])) {
+        ++j;
+      }
+      merged_keys.PushBack(take(keys_[i]));
+      merged_values.PushBack(take(values_[i]));
+      ++i;
+    }
+  }
+  for (; i < keys_.Size(); ++i) {
+    merged_keys.PushBack(take(keys_[i]));
+    merged_values.PushBack(take(values_[i]));
+  }
+  for (; j < added_keys.Size(); ++j) {
+    merged_keys.PushBack(std::move(added_keys[j]));
+    merged_values.PushBack(std::move(added_values[j]));
+  }
+  keys_.Swap(merged_keys);
+  values_.Swap(merged_values);
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+bool FlatMap<K, V, Compare, Allocator>::Erase(const K &key) {
+  std::size_t idx = FindIndex(key);
+  if (idx == keys_.Size()) {
+    return false;
+  }
+  index_.Clear();
+  keys_.Delete(idx);
+  values_.Delete(idx);
+  return true;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+const typename FlatMap<K, V, Compare, Allocator>::KeyVector &
+FlatMap<K, V, Compare, Allocator>::Keys() const noexcept {
+  return keys_;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+const typename FlatMap<K, V, Compare, Allocator>::ValueVector &
+FlatMap<K, V, Compare, Allocator>::Values() const noexcept {
+  return values_;
+}
+template <typename K, typename V, typename Compare, typename Allocator>
+void FlatMap<K, V, Compare, Allocator>::BuildEytzingerIndex() {
+  index_.Build(keys_);
+}
+}; // namespace flat
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+
+#include <flat/search.hpp>
+#include <vector/vector.hpp>
+
+namespace flat {
+// Sorted set stored contiguously in a vector::Vector.
+template <typename K, typename Compare = std::less<K>,
+          typename Allocator = std::pmr::polymorphic_allocator<K>>
+class FlatSet {
+public:
+  using const_iterator = typename vector::Vector<K, Allocator>::const_iterator;
+
+  explicit FlatSet(const Allocator &allocator = Allocator(),
+                   const Compare &comp = Compare());
+  // Sorts once and drops duplicates.
+  template <typename InputIt>
+  FlatSet(InputIt first, InputIt last, const Allocator &allocator = Allocator(),
+          const Compare &comp = Compare());
+  FlatSet(const std::initializer_list<K> &list,
+          const Allocator &allocator = Allocator(),
+          const Compare &comp = Compare());
+  std::size_t Size() const noexcept;
+  bool Contains(const K &key) const;
+  const_iterator Find(const K &key) const;
+  const_iterator LowerBound(const K &key) const;
+  bool Insert(const K &key);
+  bool Insert(K &&key);
+  // Sorts the new keys and merges them in one pass instead of shifting
+  // the tail once per key.
+  template <typename InputIt> void InsertRange(InputIt first, InputIt last);
+  bool Erase(const K &key);
+  const K &operator[](std::size_t idx) const noexcept;
+  const vector::Vector<K, Allocator> &Keys() const noexcept;
+  // Speeds up lookups on large read-mostly sets, dropped on mutation.
+  void BuildEytzingerIndex();
+  const_iterator CBegin() const;
+  const_iterator CEnd() const;
+
+private:
+  std::size_t LowerBoundIndex(const K &key) const;
+  template <typename U> bool InsertInternal(U &&key);
+  void SortUnique(vector::Vector<K, Allocator> &keys) const;
+
+private:
+  [[no_unique_address]] Compare comp_;
+  vector::Vector<K, Allocator> keys_;
+  EytzingerIndex<K, Allocator> index_;
+};
+}; // namespace flat
+#include <flat/flat_set.ipp>
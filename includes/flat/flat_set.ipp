@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <utility>
+
+#include <flat/flat_set.hpp>
+
+namespace flat {
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::FlatSet(const Allocator &allocator,
+                                        const Compare &comp)
+    : comp_(comp), keys_(allocator), index_(allocator) {}
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+FlatSet<K, Compare, Allocator>::FlatSet(InputIt first, InputIt last,
+                                        const Allocator &allocator,
+                                        const Compare &comp)
+    : comp_(comp), keys_(allocator), index_(allocator) {
+  for (; first != last; ++first) {
+    keys_.PushBack(*first);
+  }
+  SortUnique(keys_);
+}
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::FlatSet(const std::initializer_list<K> &list,
+                                        const Allocator &allocator,
+                                        const Compare &comp)
+    : FlatSet(list.begin(), list.end(), allocator, comp) {}
+template <typename K, typename Compare, typename Allocator>
+void FlatSet<K, Compare, Allocator>::SortUnique(
+    vector::Vector<K, Allocator> &keys) const {
+  std::sort(keys.Begin(), keys.End(), comp_);
+  auto last = std::unique(keys.Begin(), keys.End(),
+                          [this](const K &a, const K &b) {
+                            return !comp_(a, b);
+                          });
+  while (keys.End() != last) {
+    keys.PopBack();
+  }
+}
+template <typename K, typename Compare, typename Allocator>
+std::size_t FlatSet<K, Compare, Allocator>::Size() const noexcept {
+  return keys_.Size();
+}
+template <typename K, typename Compare, typename Allocator>
+std::size_t
+FlatSet<K, Compare, Allocator>::LowerBoundIndex(const K &key) const {
+  if (index_.Built()) {
+    return index_.LowerBound(key, comp_);
+  }
+  const K *keys = keys_.Size() == 0 ? nullptr : &keys_[0];
+  return flat::LowerBound(keys, keys_.Size(), key, comp_);
+}
+template <typename K, typename Compare, typename Allocator>
+bool FlatSet<K, Compare, Allocator>::Contains(const K &key) const {
+  std::size_t idx = LowerBoundIndex(key);
+  return idx != keys_.Size() && !comp_(key, keys_[idx]);
+}
+template <typename K, typename Compare, typename Allocator>
+typename FlatSet<K, Compare, Allocator>::const_iterator
+FlatSet<K, Compare, Allocator>::Find(const K &key) const {
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx != keys_.Size() && !comp_(key, keys_[idx])) {
+    return CBegin() + idx;
+  }
+  return CEnd();
+}
+template <typename K, typename Compare, typename Allocator>
+typename FlatSet<K, Compare, Allocator>::const_iterator
+FlatSet<K, Compare, Allocator>::LowerBound(const K &key) const {
+  return CBegin() + LowerBoundIndex(key);
+}
+template <typename K, typename Compare, typename Allocator>
+bool FlatSet<K, Compare, Allocator>::Insert(const K &key) {
+  return InsertInternal(key);
+}
+template <typename K, typename Compare, typename Allocator>
+bool FlatSet<K, Compare, Allocator>::Insert(K &&key) {
+  return InsertInternal(std::move(key));
+}
+template <typename K, typename Compare, typename Allocator>
+template <typename U>
+bool FlatSet<K, Compare, Allocator>::InsertInternal(U &&key) {
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx != keys_.Size() && !comp_(key, keys_[idx])) {
+    return false;
+  }
+  index_.Clear();
+  keys_.Insert(idx, std::forward<U>(key));
+  return true;
+}
+template <typename K, typename Compare, typename Allocator>
+template <typename InputIt>
+void FlatSet<K, Compare, Allocator>::InsertRange(InputIt first,
+                                                 InputIt last) {
+  vector::Vector<K, Allocator> added(keys_.GetAllocator());
+  for (; first != last; ++first) {
+    added.PushBack(*first);
+  }
+  if (added.Size() == 0) {
+    return;
+  }
+  SortUnique(added);
+  index_.Clear();
+  vector::Vector<K, Allocator> merged(keys_.GetAllocator());
+  merged.Reserve(keys_.Size() + added.Size());
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < keys_.Size() && j < added.Size()) {
+    if (comp_(added[j], keys_[i])) {
+      merged.PushBack(std::move(added[j++]));
+    } else {
+      if (!comp_(keys_[i], added[j])) {
+        ++j;
+      }
+      merged.PushBack(std::move_if_noexcept(keys_[i++]));
+    }
+  }
+  for (; i < keys_.Size(); ++i) {
+    merged.PushBack(std::move_if_noexcept(keys_[i]));
+  }
+  for (; j < added.Size(); ++j) {
+    merged.PushBack(std::move(added[j]));
+  }
+  keys_.Swap(merged);
+}
+template <typename K, typename Compare, typename Allocator>
+bool FlatSet<K, Compare, Allocator>::Erase(const K &key) {
+  std::size_t idx = LowerBoundIndex(key);
+  if (idx == keys_.Size() || comp_(key, keys_[idx])) {
+    return false;
+  }
+  index_.Clear();
+  keys_.Delete(idx);
+  return true;
+}
+template <typename K, typename Compare, typename Allocator>
+const K &
+FlatSet<K, Compare, Allocator>::operator[](std::size_t idx) const noexcept {
+  return keys_[idx];
+}
+template <typename K, typename Compare, typename Allocator>
+const vector::Vector<K, Allocator> &
+FlatSet<K, Compare, Allocator>::Keys() const noexcept {
+  return keys_;
+}
+template <typename K, typename Compare, typename Allocator>
+void FlatSet<K, Compare, Allocator>::BuildEytzingerIndex() {
+  index_.Build(keys_);
+}
+template <typename K, typename Compare, typename Allocator>
+typename FlatSet<K, Compare, Allocator>::const_iterator
+FlatSet<K, Compare, Allocator>::CBegin() const {
+  return keys_.CBegin();
+}
+template <typename K, typename Compare, typename Allocator>
+typename FlatSet<K, Compare, Allocator>::const_iterator
+FlatSet<K, Compare, Allocator>::CEnd() const {
+  return keys_.CEnd();
+}
+}; // namespace flat
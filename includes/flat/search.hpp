@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include <vector/vector.hpp>
+
+namespace flat {
+// Lower bound over a sorted array without data-dependent branches, the
+// comparison result only selects the next base pointer.
+template <typename K, typename Compare>
+std::size_t LowerBound(const K *keys, std::size_t size, const K &key,
+                       const Compare &comp);
+
+// Copy of sorted keys in Eytzinger (BFS) order. Searching it touches
+// one cache line per few tree levels and lets the next levels be
+// prefetched, which pays off for large read-mostly tables.
+template <typename K, typename Allocator> class EytzingerIndex {
+private:
+  using RankAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<std::size_t>;
+
+public:
+  explicit EytzingerIndex(const Allocator &allocator);
+  void Build(const vector::Vector<K, Allocator> &sorted);
+  void Clear();
+  bool Built() const noexcept;
+  // Position of the lower bound in the sorted array, size if none.
+  template <typename Compare>
+  std::size_t LowerBound(const K &key, const Compare &comp) const;
+
+private:
+  void FillRanks(std::size_t node, std::size_t &rank);
+
+private:
+  vector::Vector<K, Allocator> keys_;
+  vector::Vector<std::size_t, RankAllocator> ranks_;
+};
+}; // namespace flat
+#include <flat/search.ipp>
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <algorithm>
+
+#include <flat/search.hpp>
+
+namespace flat {
+template <typename K, typename Compare>
+std::size_t LowerBound(const K *keys, std::size_t size, const K &key,
+                       const Compare &comp) {
+  const K *base = keys;
+  std::size_t length = size;
+  while (length > 1) {
+    std::size_t half = length / 2;
+    base = comp(base[half - 1], key) ? base + half : base;
+    length -= half;
+  }
+  return (base - keys) + (length == 1 && comp(*base, key));
+}
+
+template <typename K, typename Allocator>
+EytzingerIndex<K, Allocator>::EytzingerIndex(const Allocator &allocator)
+    : keys_(allocator), ranks_(RankAllocator(allocator)) {}
+template <typename K, typename Allocator>
+void EytzingerIndex<K, Allocator>::Build(
+    const vector::Vector<K, Allocator> &sorted) {
+  Clear();
+  std::size_t size = sorted.Size();
+  keys_.Reserve(size);
+  ranks_.Reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    ranks_.PushBack(0);
+  }
+  std::size_t rank = 0;
+  FillRanks(1, rank);
+  for (std::size_t i = 0; i < size; ++i) {
+    keys_.PushBack(sorted[ranks_[i]]);
+  }
+}
+template <typename K, typename Allocator>
+void EytzingerIndex<K, Allocator>::FillRanks(std::size_t node,
+                                             std::size_t &rank) {
+  if (node > ranks_.Size()) {
+    return;
+  }
+  FillRanks(2 * node, rank);
+  ranks_[node - 1] = rank++;
+  FillRanks(2 * node + 1, rank);
+}
+template <typename K, typename Allocator>
+void EytzingerIndex<K, Allocator>::Clear() {
+  while (keys_.Size() != 0) {
+    keys_.PopBack();
+  }
+  while (ranks_.Size() != 0) {
+    ranks_.PopBack();
+  }
+}
+template <typename K, typename Allocator>
+bool EytzingerIndex<K, Allocator>::Built() const noexcept {
+  return keys_.Size() != 0;
+}
+template <typename K, typename Allocator>
+template <typename Compare>
+std::size_t
+EytzingerIndex<K, Allocator>::LowerBound(const K &key,
+                                         const Compare &comp) const {
+  std::size_t size = keys_.Size();
+  const K *keys = size == 0 ? nullptr : &keys_[0];
+  std::size_t node = 1;
+  while (node <= size) {
+    __builtin_prefetch(keys + std::min(16 * node, size) - 1);
+    node = 2 * node + comp(keys[node - 1], key);
+  }
+  // Drop the trailing right turns to get back to the last left turn.
+  node >>= __builtin_ffsll(~node);
+  return node == 0 ? size : ranks_[node - 1];
+}
+}; // namespace flat
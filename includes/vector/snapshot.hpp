@@ -0,0 +1,79 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace vector {
+template <typename T, typename Allocator> class Vector;
+
+// Reference-counted element buffer shared between a Vector and its
+// snapshots. While shared, the elements are never modified.
+template <typename T, typename Allocator> class SharedBuffer {
+private:
+  using HeaderAllocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<SharedBuffer>;
+
+public:
+  SharedBuffer(T *arr, std::size_t size, std::size_t capacity,
+               const Allocator &allocator) noexcept;
+  static SharedBuffer *Create(T *arr, std::size_t size, std::size_t capacity,
+                              const Allocator &allocator);
+  void Acquire() noexcept;
+  // Drops one reference, destroys elements and buffer with the last one.
+  void Release() noexcept;
+  // Frees only the header, the sole owner keeps the element buffer.
+  void Unwrap() noexcept;
+  bool IsUnique() const noexcept;
+  T *Data() const noexcept;
+  std::size_t Size() const noexcept;
+  std::size_t Capacity() const noexcept;
+  const Allocator &GetAllocator() const noexcept;
+
+private:
+  void Free() noexcept;
+
+private:
+  std::atomic<std::size_t> refs_;
+  std::size_t size_;
+  std::size_t capacity_;
+  Allocator allocator_;
+  T *arr_;
+};
+
+// Immutable O(1) view of a Vector. Readers need no locks, the buffer is
+// kept alive until the last snapshot is gone. The memory resource behind
+// the allocator must outlive all snapshots.
+// Constraints:
+// - References, pointers and iterators obtained from the non-const Vector
+//   accessors before TakeSnapshot() still point into the shared buffer.
+//   Writing through them changes every snapshot, so drop them first.
+// - Whoever drops the last reference frees the buffer through the
+//   allocator on its own thread. With a resource that is not thread-safe,
+//   such as DynamicMemoryResource, release snapshots on the writer thread.
+template <typename T, typename Allocator> class Snapshot {
+public:
+  Snapshot() noexcept;
+  Snapshot(const Snapshot &) noexcept;
+  Snapshot &operator=(const Snapshot &) noexcept;
+  Snapshot(Snapshot &&) noexcept;
+  Snapshot &operator=(Snapshot &&) noexcept;
+  ~Snapshot();
+  const T &operator[](std::size_t idx) const noexcept;
+  const T &At(std::size_t idx) const;
+  std::size_t Size() const noexcept;
+  const T *Data() const noexcept;
+  const T &Front() const noexcept;
+  const T &Back() const noexcept;
+  typename Vector<T, Allocator>::const_iterator CBegin() const;
+  typename Vector<T, Allocator>::const_iterator CEnd() const;
+
+private:
+  explicit Snapshot(SharedBuffer<T, Allocator> *buffer) noexcept;
+  friend class Vector<T, Allocator>;
+
+private:
+  SharedBuffer<T, Allocator> *buffer_;
+};
+}; // namespace vector
+#include <vector/snapshot.ipp>
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <utility>
+
+#include <vector/snapshot.hpp>
+#include <vector/vector_exceptions.hpp>
+
+namespace vector {
+template <typename T, typename Allocator>
+SharedBuffer<T, Allocator>::SharedBuffer(T *arr, std::size_t size,
+                                         std::size_t capacity,
+                                         const Allocator &allocator) noexcept
+    : refs_(1), size_(size), capacity_(capacity), allocator_(allocator),
+      arr_(arr) {}
+template <typename T, typename Allocator>
+SharedBuffer<T, Allocator> *
+SharedBuffer<T, Allocator>::Create(T *arr, std::size_t size,
+                                   std::size_t capacity,
+                                   const Allocator &allocator) {
+  HeaderAllocator header_allocator(allocator);
+  SharedBuffer *buffer =
+      std::allocator_traits<HeaderAllocator>::allocate(header_allocator, 1);
+  std::allocator_traits<HeaderAllocator>::construct(
+      header_allocator, buffer, arr, size, capacity, allocator);
+  return buffer;
+}
+template <typename T, typename Allocator>
+void SharedBuffer<T, Allocator>::Acquire() noexcept {
+  refs_.fetch_add(1, std::memory_order_relaxed);
+}
+template <typename T, typename Allocator>
+void SharedBuffer<T, Allocator>::Release() noexcept {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  for (std::size_t i = 0; i < size_; ++i) {
+    std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
+  }
+  if (arr_ != nullptr) {
+    std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  }
+  Free();
+}
+template <typename T, typename Allocator>
+void SharedBuffer<T, Allocator>::Unwrap() noexcept {
+  Free();
+}
+template <typename T, typename Allocator>
+void SharedBuffer<T, Allocator>::Free() noexcept {
+  HeaderAllocator header_allocator(allocator_);
+  SharedBuffer *self = this;
+  std::allocator_traits<HeaderAllocator>::destroy(header_allocator, self);
+  std::allocator_traits<HeaderAllocator>::deallocate(header_allocator, self,
+                                                     1);
+}
+template <typename T, typename Allocator>
+bool SharedBuffer<T, Allocator>::IsUnique() const noexcept {
+  return refs_.load(std::memory_order_acquire) == 1;
+}
+template <typename T, typename Allocator>
+T *SharedBuffer<T, Allocator>::Data() const noexcept {
+  return arr_;
+}
+template <typename T, typename Allocator>
+std::size_t SharedBuffer<T, Allocator>::Size() const noexcept {
+  return size_;
+}
+template <typename T, typename Allocator>
+std::size_t SharedBuffer<T, Allocator>::Capacity() const noexcept {
+  return capacity_;
+}
+template <typename T, typename Allocator>
+const Allocator &SharedBuffer<T, Allocator>::GetAllocator() const noexcept {
+  return allocator_;
+}
+
+template <typename T, typename Allocator>
+Snapshot<T, Allocator>::Snapshot() noexcept : buffer_(nullptr) {}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator>::Snapshot(SharedBuffer<T, Allocator> *buffer) noexcept
+    : buffer_(buffer) {}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator>::Snapshot(
+    const Snapshot<T, Allocator> &snapshot) noexcept
+    : buffer_(snapshot.buffer_) {
+  if (buffer_ != nullptr) {
+    buffer_->Acquire();
+  }
+}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator> &
+Snapshot<T, Allocator>::operator=(
+    const Snapshot<T, Allocator> &snapshot) noexcept {
+  Snapshot<T, Allocator> copy(snapshot);
+  std::swap(buffer_, copy.buffer_);
+  return *this;
+}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator>::Snapshot(Snapshot<T, Allocator> &&snapshot) noexcept
+    : buffer_(snapshot.buffer_) {
+  snapshot.buffer_ = nullptr;
+}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator> &
+Snapshot<T, Allocator>::operator=(Snapshot<T, Allocator> &&snapshot) noexcept {
+  Snapshot<T, Allocator> moved(std::move(snapshot));
+  std::swap(buffer_, moved.buffer_);
+  return *this;
+}
+template <typename T, typename Allocator> Snapshot<T, Allocator>::~Snapshot() {
+  if (buffer_ != nullptr) {
+    buffer_->Release();
+  }
+}
+template <typename T, typename Allocator>
+const T &Snapshot<T, Allocator>::operator[](std::size_t idx) const noexcept {
+  return buffer_->Data()[idx];
+}
+template <typename T, typename Allocator>
+const T &Snapshot<T, Allocator>::At(std::size_t idx) const {
+  if (idx >= Size()) {
+    throw vector::OutOfBounds();
+  }
+  return buffer_->Data()[idx];
+}
+template <typename T, typename Allocator>
+std::size_t Snapshot<T, Allocator>::Size() const noexcept {
+  return buffer_ == nullptr ? 0 : buffer_->Size();
+}
+template <typename T, typename Allocator>
+const T *Snapshot<T, Allocator>::Data() const noexcept {
+  return buffer_ == nullptr ? nullptr : buffer_->Data();
+}
+template <typename T, typename Allocator>
+const T &Snapshot<T, Allocator>::Front() const noexcept {
+  return buffer_->Data()[0];
+}
+template <typename T, typename Allocator>
+const T &Snapshot<T, Allocator>::Back() const noexcept {
+  return buffer_->Data()[buffer_->Size() - 1];
+}
+template <typename T, typename Allocator>
+typename Vector<T, Allocator>::const_iterator
+Snapshot<T, Allocator>::CBegin() const {
+  if (buffer_ == nullptr) {
+    return typename Vector<T, Allocator>::const_iterator();
+  }
+  return typename Vector<T, Allocator>::const_iterator(buffer_->Data());
+}
+template <typename T, typename Allocator>
+typename Vector<T, Allocator>::const_iterator
+Snapshot<T, Allocator>::CEnd() const {
+  if (buffer_ == nullptr) {
+    return typename Vector<T, Allocator>::const_iterator();
+  }
+  return typename Vector<T, Allocator>::const_iterator(buffer_->Data() +
+                                                       buffer_->Size());
+}
+}; // namespace vector
@@ -4,8 +4,11 @@
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
+#include <memory_resource>
 #include <type_traits>
 
+#include <vector/snapshot.hpp>
+
 namespace vector {
 template <typename T>
 concept Escapable =
@@ -18,53 +21,72 @@ private:
   std::size_t capacity_;
   Allocator allocator_;
   T *arr_;
+  SharedBuffer<T, Allocator> *shared_;
 
 public:
-  Vector();
-  explicit Vector(std::size_t size, const Allocator &allocator = Allocator())
+  using value_type = T;
+
+  constexpr Vector();
+  // Does not allocate until the first element is added.
+  explicit constexpr Vector(const Allocator &allocator);
+  explicit constexpr Vector(std::size_t size,
+                            const Allocator &allocator = Allocator())
     requires std::is_default_constructible_v<T>;
-  Vector(std::size_t size, const T &value,
-         const Allocator &allocator = Allocator())
+  constexpr Vector(std::size_t size, const T &value,
+                   const Allocator &allocator = Allocator())
     requires std::copy_constructible<T>;
-  Vector(const std::initializer_list<T> &,
-         const Allocator &allocator = Allocator());
-  Vector(const Vector &)
+  constexpr Vector(const std::initializer_list<T> &,
+                   const Allocator &allocator = Allocator());
+  constexpr Vector(const Vector &)
     requires std::copy_constructible<T>;
-  Vector &operator=(const Vector<T, Allocator> &)
+  // Shares the snapshot buffer, the copy is made on first mutation.
+  explicit Vector(const Snapshot<T, Allocator> &)
     requires std::copy_constructible<T>;
-  Vector(Vector<T, Allocator> &&) noexcept;
-  Vector &operator=(Vector<T, Allocator> &&) noexcept;
-  ~Vector();
-  void Swap(Vector<T, Allocator> &) noexcept;
-  T &operator[](std::size_t idx) noexcept;
-  const T &operator[](std::size_t idx) const noexcept;
-  T &At(std::size_t idx);
-  const T &At(std::size_t idx) const;
-  void PushBack(T &&value)
+  constexpr Vector &operator=(const Vector<T, Allocator> &)
+    requires std::copy_constructible<T>;
+  constexpr Vector(Vector<T, Allocator> &&) noexcept;
+  constexpr Vector &operator=(Vector<T, Allocator> &&) noexcept;
+  constexpr ~Vector();
+  constexpr void Swap(Vector<T, Allocator> &) noexcept;
+  constexpr T &operator[](std::size_t idx);
+  constexpr const T &operator[](std::size_t idx) const noexcept;
+  constexpr T &At(std::size_t idx);
+  constexpr const T &At(std::size_t idx) const;
+  constexpr void PushBack(T &&value)
     requires std::move_constructible<T>;
-  void PushBack(const T &value)
+  constexpr void PushBack(const T &value)
     requires std::copy_constructible<T>;
-  void PopBack() noexcept;
-  std::size_t Size() const noexcept;
-  std::size_t Capacity() const noexcept;
-  void Delete(std::size_t idx)
+  constexpr void PopBack();
+  constexpr std::size_t Size() const noexcept;
+  constexpr std::size_t Capacity() const noexcept;
+  constexpr Allocator GetAllocator() const noexcept;
+  constexpr void Delete(std::size_t idx)
     requires Escapable<T>;
-  void Insert(std::size_t idx, const T &value)
+  constexpr void Insert(std::size_t idx, const T &value)
     requires Escapable<T>;
-  void Insert(std::size_t idx, T &&value)
+  constexpr void Insert(std::size_t idx, T &&value)
     requires Escapable<T>;
-  void Reserve(std::size_t new_capacity)
+  constexpr void Reserve(std::size_t new_capacity)
     requires Escapable<T>;
-  T *Data() noexcept;
-  T &Front() noexcept;
-  T &Back() noexcept;
-  const T &Front() const noexcept;
-  const T &Back() const noexcept;
+  constexpr T *Data();
+  constexpr T &Front();
+  constexpr T &Back();
+  constexpr const T &Front() const noexcept;
+  constexpr const T &Back() const noexcept;
+  // O(1): the buffer is shared until this vector is mutated.
+  Snapshot<T, Allocator> TakeSnapshot()
+    requires std::copy_constructible<T>;
 
 private:
-  void ReserveInternal(std::size_t new_capacity);
-  template <typename U> void PushBackInternal(U &&value);
-  template <typename U> void InsertInternal(std::size_t idx, U &&value);
+  constexpr void ReserveInternal(std::size_t new_capacity);
+  constexpr void Detach();
+  constexpr void Fork(std::size_t new_capacity);
+  constexpr void ReleaseStorage() noexcept;
+  template <typename U> constexpr void PushBackInternal(U &&value);
+  template <typename U>
+  constexpr void InsertInternal(std::size_t idx, U &&value);
+  template <typename U>
+  constexpr void InsertIntoNewBuffer(std::size_t idx, U &&value);
 
 private:
   template <bool IsConst> class Iterator {
@@ -74,76 +96,79 @@ private:
     using value_type = T;
     using pointer_type = std::conditional_t<IsConst, const T *, T *>;
     using reference_type = std::conditional_t<IsConst, const T &, T &>;
-    Iterator() : ptr_(nullptr) {}
-    Iterator(T *ptr) : ptr_(ptr) {}
-    Iterator(const Iterator &other) : ptr_(other.ptr_) {}
-    Iterator &operator=(const Iterator &other) {
+    constexpr Iterator() : ptr_(nullptr) {}
+    constexpr Iterator(T *ptr) : ptr_(ptr) {}
+    constexpr Iterator(const Iterator &other) : ptr_(other.ptr_) {}
+    constexpr Iterator &operator=(const Iterator &other) {
       ptr_ = other.ptr_;
       return (*this);
     }
-    reference_type operator*() const { return *ptr_; }
-    pointer_type operator->() { return ptr_; }
-    Iterator &operator++() {
+    constexpr reference_type operator*() const { return *ptr_; }
+    constexpr pointer_type operator->() { return ptr_; }
+    constexpr Iterator &operator++() {
       ptr_++;
       return *this;
     }
-    Iterator operator++(int) {
+    constexpr Iterator operator++(int) {
       Iterator copy = *this;
       ++copy;
       return copy;
     }
-    Iterator &operator--() {
+    constexpr Iterator &operator--() {
       ptr_--;
       return *this;
     }
-    Iterator operator--(int) {
+    constexpr Iterator operator--(int) {
       Iterator copy(*this);
       --copy;
       return copy;
     }
-    friend bool operator==(const Iterator a, const Iterator b) {
+    friend constexpr bool operator==(const Iterator a, const Iterator b) {
       return a.ptr_ == b.ptr_;
     }
-    friend bool operator!=(const Iterator a, const Iterator b) {
+    friend constexpr bool operator!=(const Iterator a, const Iterator b) {
       return !(a == b);
     }
-    Iterator &operator+=(const difference_type diff) {
+    constexpr Iterator &operator+=(const difference_type diff) {
       ptr_ += diff;
       return *this;
     }
-    friend Iterator operator+(const Iterator a, const difference_type diff) {
+    friend constexpr Iterator operator+(const Iterator a,
+                                        const difference_type diff) {
       Iterator copy(a);
       copy += diff;
       return copy;
     }
-    friend Iterator operator+(const difference_type diff, const Iterator b) {
+    friend constexpr Iterator operator+(const difference_type diff,
+                                        const Iterator b) {
       return b + diff;
     }
-    Iterator &operator-=(const difference_type diff) {
+    constexpr Iterator &operator-=(const difference_type diff) {
       ptr_ -= diff;
       return *this;
     }
-    friend Iterator operator-(const Iterator a, difference_type diff) {
+    friend constexpr Iterator operator-(const Iterator a,
+                                        difference_type diff) {
       Iterator copy(a);
       copy -= diff;
       return copy;
     }
-    difference_type operator-(const Iterator other) const {
+    constexpr difference_type operator-(const Iterator other) const {
       return ptr_ - other.ptr_;
     }
-    reference_type operator[](const difference_type diff) const {
+    constexpr reference_type operator[](const difference_type diff) const {
       return ptr_[diff];
     }
-    friend bool operator<(const Iterator a, const Iterator b) {
+    friend constexpr bool operator<(const Iterator a, const Iterator b) {
       return a.ptr_ < b.ptr_;
     }
-    friend bool operator>(const Iterator a, const Iterator b) {
+    friend constexpr bool operator>(const Iterator a, const Iterator b) {
       return a.ptr_ > b.ptr_;
     }
-    friend bool operator<=(const Iterator a, const Iterator b) {
+    friend constexpr bool operator<=(const Iterator a, const Iterator b) {
       return !(a > b);
     }
-    friend bool operator>=(const Iterator a, const Iterator b) {
+    friend constexpr bool operator>=(const Iterator a, const Iterator b) {
       return !(a < b);
     }
 
@@ -154,11 +179,22 @@ private:
 public:
   using iterator = Iterator<false>;
   using const_iterator = Iterator<true>;
-  iterator Begin() { return Iterator<false>(arr_); }
-  iterator End() { return Iterator<false>(arr_ + size_); }
-  const_iterator CBegin() const { return Iterator<true>(arr_); }
-  const_iterator CEnd() const { return Iterator<true>(arr_ + size_); }
+  constexpr iterator Begin() {
+    Detach();
+    return Iterator<false>(arr_);
+  }
+  constexpr iterator End() {
+    Detach();
+    return Iterator<false>(arr_ + size_);
+  }
+  constexpr const_iterator CBegin() const { return Iterator<true>(arr_); }
+  constexpr const_iterator CEnd() const {
+    return Iterator<true>(arr_ + size_);
+  }
 };
 static_assert(std::random_access_iterator<Vector<int>::iterator>);
+// Copies the Vector returned by Build into a std::array during constant
+// evaluation. Build has to use std::allocator.
+template <auto Build> consteval auto Freeze();
 }; // namespace vector
 #include <vector/vector.ipp>
@@ -1,40 +1,51 @@
 #pragma once
 
+#include <array>
 #include <memory>
+#include <utility>
 
 #include <vector/vector.hpp>
 #include <vector/vector_exceptions.hpp>
 
 namespace vector {
-const std::size_t kDefaultCapacity = 10;
+inline constexpr std::size_t kDefaultCapacity = 10;
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector()
+constexpr Vector<T, Allocator>::Vector()
     : size_(0), capacity_(kDefaultCapacity), allocator_(Allocator()),
-      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)) {}
+      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)),
+      shared_(nullptr) {}
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(std::size_t size, const Allocator &allocator)
+constexpr Vector<T, Allocator>::Vector(const Allocator &allocator)
+    : size_(0), capacity_(0), allocator_(allocator), arr_(nullptr),
+      shared_(nullptr) {}
+template <typename T, typename Allocator>
+constexpr Vector<T, Allocator>::Vector(std::size_t size,
+                                       const Allocator &allocator)
   requires std::is_default_constructible_v<T>
     : size_(size), capacity_(size), allocator_(allocator),
-      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)) {
+      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)),
+      shared_(nullptr) {
   for (std::size_t i = 0; i < size; ++i) {
     std::allocator_traits<Allocator>::construct(allocator_, arr_ + i);
   }
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(std::size_t size, const T &value,
-                             const Allocator &allocator)
+constexpr Vector<T, Allocator>::Vector(std::size_t size, const T &value,
+                                       const Allocator &allocator)
   requires std::copy_constructible<T>
     : size_(size), capacity_(size), allocator_(allocator),
-      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)) {
+      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)),
+      shared_(nullptr) {
   for (std::size_t i = 0; i < size; ++i) {
     std::allocator_traits<Allocator>::construct(allocator_, arr_ + i, value);
   }
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const std::initializer_list<T> &list,
-                             const Allocator &allocator)
+constexpr Vector<T, Allocator>::Vector(const std::initializer_list<T> &list,
+                                       const Allocator &allocator)
     : size_(list.size()), capacity_(list.size()), allocator_(allocator),
-      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)) {
+      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)),
+      shared_(nullptr) {
   std::size_t i = 0;
   for (const T &val : list) {
     std::allocator_traits<Allocator>::construct(allocator_, arr_ + i, val);
@@ -42,39 +53,106 @@ Vector<T, Allocator>::Vector(const std::initializer_list<T> &list,
   }
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Vector<T, Allocator> &vec)
+constexpr Vector<T, Allocator>::Vector(const Vector<T, Allocator> &vec)
   requires std::copy_constructible<T>
     : size_(vec.size_), capacity_(vec.capacity_),
       allocator_(std::allocator_traits<Allocator>::
                      select_on_container_copy_construction(vec.allocator_)),
-      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)) {
+      arr_(std::allocator_traits<Allocator>::allocate(allocator_, capacity_)),
+      shared_(nullptr) {
   for (std::size_t i = 0; i < vec.size_; ++i) {
     std::allocator_traits<Allocator>::construct(allocator_, arr_ + i,
                                                 vec.arr_[i]);
   }
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::Swap(Vector<T, Allocator> &vec) noexcept {
+Vector<T, Allocator>::Vector(const Snapshot<T, Allocator> &snapshot)
+  requires std::copy_constructible<T>
+    : size_(snapshot.Size()), capacity_(0),
+      allocator_(snapshot.buffer_ == nullptr
+                     ? Allocator()
+                     : snapshot.buffer_->GetAllocator()),
+      arr_(nullptr), shared_(snapshot.buffer_) {
+  if (shared_ != nullptr) {
+    shared_->Acquire();
+    capacity_ = shared_->Capacity();
+    arr_ = shared_->Data();
+  }
+}
+template <typename T, typename Allocator>
+Snapshot<T, Allocator> Vector<T, Allocator>::TakeSnapshot()
+  requires std::copy_constructible<T>
+{
+  if (shared_ == nullptr) {
+    shared_ = SharedBuffer<T, Allocator>::Create(arr_, size_, capacity_,
+                                                 allocator_);
+  }
+  shared_->Acquire();
+  return Snapshot<T, Allocator>(shared_);
+}
+template <typename T, typename Allocator>
+constexpr void Vector<T, Allocator>::Detach() {
+  if (shared_ == nullptr) {
+    return;
+  }
+  if (shared_->IsUnique()) {
+    shared_->Unwrap();
+    shared_ = nullptr;
+    return;
+  }
+  Fork(capacity_);
+}
+template <typename T, typename Allocator>
+constexpr void Vector<T, Allocator>::Fork(std::size_t new_capacity) {
+  if constexpr (std::copy_constructible<T>) {
+    T *new_arr =
+        std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
+    for (std::size_t i = 0; i < size_; ++i) {
+      std::allocator_traits<Allocator>::construct(allocator_, new_arr + i,
+                                                  arr_[i]);
+    }
+    shared_->Release();
+    shared_ = nullptr;
+    arr_ = new_arr;
+    capacity_ = new_capacity;
+  }
+}
+template <typename T, typename Allocator>
+constexpr void Vector<T, Allocator>::ReleaseStorage() noexcept {
+  if (shared_ != nullptr) {
+    shared_->Release();
+    shared_ = nullptr;
+    return;
+  }
+  for (std::size_t i = 0; i < size_; ++i) {
+    std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
+  }
+  // Moved-from vectors hold no buffer, which std::allocator rejects during
+  // constant evaluation.
+  if (arr_ != nullptr) {
+    std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  }
+}
+template <typename T, typename Allocator>
+constexpr void Vector<T, Allocator>::Swap(Vector<T, Allocator> &vec) noexcept {
   std::swap(arr_, vec.arr_);
   std::swap(size_, vec.size_);
   std::swap(capacity_, vec.capacity_);
+  std::swap(shared_, vec.shared_);
   if constexpr (std::allocator_traits<
                     Allocator>::propagate_on_container_swap::value) {
     std::swap(allocator_, vec.allocator_);
   }
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator> &
+constexpr Vector<T, Allocator> &
 Vector<T, Allocator>::operator=(const Vector<T, Allocator> &vec)
   requires std::copy_constructible<T>
 {
   if (this == &vec) {
     return *this;
   }
-  for (std::size_t i = 0; i < size_; ++i) {
-    std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
-  }
-  std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  ReleaseStorage();
   if constexpr (std::allocator_traits<
                     Allocator>::propagate_on_container_copy_assignment::value) {
     if (allocator_ != vec.allocator_) {
@@ -92,23 +170,22 @@ Vector<T, Allocator>::operator=(const Vector<T, Allocator> &vec)
   return *this;
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(Vector<T, Allocator> &&vec) noexcept
+constexpr Vector<T, Allocator>::Vector(Vector<T, Allocator> &&vec) noexcept
     : size_(vec.size_), capacity_(vec.capacity_),
-      allocator_(std::move(vec.allocator_)), arr_(vec.arr_) {
+      allocator_(std::move(vec.allocator_)), arr_(vec.arr_),
+      shared_(vec.shared_) {
   vec.arr_ = nullptr;
+  vec.shared_ = nullptr;
   vec.size_ = 0;
   vec.capacity_ = 0;
 }
 template <typename T, typename Allocator>
-Vector<T, Allocator> &
+constexpr Vector<T, Allocator> &
 Vector<T, Allocator>::operator=(Vector<T, Allocator> &&vec) noexcept {
   if (this == &vec) {
     return *this;
   }
-  for (std::size_t i = 0; i < vec.size_; ++i) {
-    std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
-  }
-  std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  ReleaseStorage();
   if constexpr (std::allocator_traits<
                     Allocator>::propagate_on_container_move_assignment::value) {
     allocator_ = std::move(vec.allocator_);
@@ -116,41 +193,44 @@ Vector<T, Allocator>::operator=(Vector<T, Allocator> &&vec) noexcept {
   size_ = vec.size_;
   capacity_ = vec.capacity_;
   arr_ = vec.arr_;
+  shared_ = vec.shared_;
   vec.arr_ = nullptr;
+  vec.shared_ = nullptr;
   vec.size_ = 0;
   vec.capacity_ = 0;
   return *this;
 }
-template <typename T, typename Allocator> Vector<T, Allocator>::~Vector() {
-  for (std::size_t i = 0; i < size_; ++i) {
-    std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
-  }
-  std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+template <typename T, typename Allocator>
+constexpr Vector<T, Allocator>::~Vector() {
+  ReleaseStorage();
 }
 template <typename T, typename Allocator>
-T &Vector<T, Allocator>::operator[](std::size_t idx) noexcept {
+constexpr T &Vector<T, Allocator>::operator[](std::size_t idx) {
+  Detach();
   return arr_[idx];
 }
 template <typename T, typename Allocator>
-const T &Vector<T, Allocator>::operator[](std::size_t idx) const noexcept {
+constexpr const T &
+Vector<T, Allocator>::operator[](std::size_t idx) const noexcept {
   return arr_[idx];
 }
 template <typename T, typename Allocator>
-T &Vector<T, Allocator>::At(std::size_t idx) {
+constexpr T &Vector<T, Allocator>::At(std::size_t idx) {
   if (idx >= size_) {
     throw vector::OutOfBounds();
   }
+  Detach();
   return arr_[idx];
 }
 template <typename T, typename Allocator>
-const T &Vector<T, Allocator>::At(std::size_t idx) const {
+constexpr const T &Vector<T, Allocator>::At(std::size_t idx) const {
   if (idx >= size_) {
     throw vector::OutOfBounds();
   }
   return arr_[idx];
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::Reserve(std::size_t new_capacity)
+constexpr void Vector<T, Allocator>::Reserve(std::size_t new_capacity)
   requires Escapable<T>
 {
   if (capacity_ < new_capacity) {
@@ -158,7 +238,12 @@ void Vector<T, Allocator>::Reserve(std::size_t new_capacity)
   }
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::ReserveInternal(std::size_t new_capacity) {
+constexpr void Vector<T, Allocator>::ReserveInternal(std::size_t new_capacity) {
+  if (shared_ != nullptr && !shared_->IsUnique()) {
+    Fork(new_capacity);
+    return;
+  }
+  Detach();
   T *new_arr =
       std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
   for (std::size_t i = 0; i < size_; ++i) {
@@ -168,90 +253,105 @@ void Vector<T, Allocator>::ReserveInternal(std::size_t new_capacity) {
   for (std::size_t i = 0; i < size_; ++i) {
     std::allocator_traits<Allocator>::destroy(allocator_, arr_ + i);
   }
-  std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  if (arr_ != nullptr) {
+    std::allocator_traits<Allocator>::deallocate(allocator_, arr_, capacity_);
+  }
   arr_ = new_arr;
   capacity_ = new_capacity;
 }
 
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::PushBack(T &&value)
+constexpr void Vector<T, Allocator>::PushBack(T &&value)
   requires std::move_constructible<T>
 {
   PushBackInternal(std::move(value));
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::PushBack(const T &value)
+constexpr void Vector<T, Allocator>::PushBack(const T &value)
   requires std::copy_constructible<T>
 {
   PushBackInternal(value);
 }
 template <typename T, typename Allocator>
 template <typename U>
-void Vector<T, Allocator>::PushBackInternal(U &&value) {
+constexpr void Vector<T, Allocator>::PushBackInternal(U &&value) {
+  // Growing a shared buffer copies straight into the new capacity.
   if (size_ >= capacity_) {
     if (capacity_ == 0) {
       ReserveInternal(kDefaultCapacity);
     } else {
       ReserveInternal(capacity_ * 2);
     }
+  } else {
+    Detach();
   }
   std::allocator_traits<Allocator>::construct(allocator_, arr_ + size_,
                                               std::forward<U>(value));
   ++size_;
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::PopBack() noexcept {
+constexpr void Vector<T, Allocator>::PopBack() {
+  Detach();
   std::allocator_traits<Allocator>::destroy(allocator_, arr_ + size_ - 1);
   --size_;
 }
 template <typename T, typename Allocator>
-T &Vector<T, Allocator>::Front() noexcept {
+constexpr T &Vector<T, Allocator>::Front() {
+  Detach();
   return arr_[0];
 }
 template <typename T, typename Allocator>
-T &Vector<T, Allocator>::Back() noexcept {
+constexpr T &Vector<T, Allocator>::Back() {
+  Detach();
   return arr_[size_ - 1];
 }
 template <typename T, typename Allocator>
-const T &Vector<T, Allocator>::Front() const noexcept {
+constexpr const T &Vector<T, Allocator>::Front() const noexcept {
   return arr_[0];
 }
 template <typename T, typename Allocator>
-const T &Vector<T, Allocator>::Back() const noexcept {
+constexpr const T &Vector<T, Allocator>::Back() const noexcept {
   return arr_[size_ - 1];
 }
 template <typename T, typename Allocator>
-T *Vector<T, Allocator>::Data() noexcept {
+constexpr T *Vector<T, Allocator>::Data() {
+  Detach();
   return arr_;
 }
 template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::Size() const noexcept {
+constexpr std::size_t Vector<T, Allocator>::Size() const noexcept {
   return size_;
 }
 template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::Capacity() const noexcept {
+constexpr std::size_t Vector<T, Allocator>::Capacity() const noexcept {
   return capacity_;
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::Delete(std::size_t idx)
+constexpr Allocator Vector<T, Allocator>::GetAllocator() const noexcept {
+  return allocator_;
+}
+template <typename T, typename Allocator>
+constexpr void Vector<T, Allocator>::Delete(std::size_t idx)
   requires Escapable<T>
 {
   if (idx >= size_) {
     throw vector::OutOfBounds();
   }
+  Detach();
   for (std::size_t i = idx; i < size_ - 1; ++i) {
     arr_[i] = std::move_if_noexcept(arr_[i + 1]);
   }
+  std::allocator_traits<Allocator>::destroy(allocator_, arr_ + size_ - 1);
   --size_;
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::Insert(std::size_t idx, const T &value)
+constexpr void Vector<T, Allocator>::Insert(std::size_t idx, const T &value)
   requires Escapable<T>
 {
   InsertInternal(idx, value);
 }
 template <typename T, typename Allocator>
-void Vector<T, Allocator>::Insert(std::size_t idx, T &&value)
+constexpr void Vector<T, Allocator>::Insert(std::size_t idx, T &&value)
   requires Escapable<T>
 {
   InsertInternal(idx, std::move(value));
@@ -259,27 +359,103 @@ void Vector<T, Allocator>::Insert(std::size_t idx, T &&value)
 
 template <typename T, typename Allocator>
 template <typename U>
-void Vector<T, Allocator>::InsertInternal(std::size_t idx, U &&value) {
+constexpr void Vector<T, Allocator>::InsertInternal(std::size_t idx,
+                                                    U &&value) {
   if (idx > size_) {
     throw vector::OutOfBounds();
   }
-  if (size_ == capacity_) {
-    if (capacity_ == 0) {
-      ReserveInternal(kDefaultCapacity);
+  if constexpr (!std::is_nothrow_move_constructible_v<T> ||
+                !std::is_nothrow_move_assignable_v<T>) {
+    InsertIntoNewBuffer(idx, std::forward<U>(value));
+  } else {
+    // Only building the element can throw once the tail is shifted, so do
+    // it before touching the buffer.
+    T element(std::forward<U>(value));
+    if (size_ == capacity_) {
+      if (capacity_ == 0) {
+        ReserveInternal(kDefaultCapacity);
+      } else {
+        ReserveInternal(capacity_ * 2);
+      }
     } else {
-      ReserveInternal(capacity_ * 2);
+      Detach();
+    }
+    if (idx == size_) {
+      std::allocator_traits<Allocator>::construct(allocator_, arr_ + size_,
+                                                  std::move(element));
+      ++size_;
+      return;
+    }
+    std::allocator_traits<Allocator>::construct(allocator_, arr_ + size_,
+                                                std::move(arr_[size_ - 1]));
+    for (std::size_t i = size_ - 1; i > idx; --i) {
+      arr_[i] = std::move(arr_[i - 1]);
     }
+    arr_[idx] = std::move(element);
+    ++size_;
   }
-  std::allocator_traits<Allocator>::construct(
-      allocator_, arr_ + size_, std::move_if_noexcept(arr_[size_ - 1]));
-  for (std::size_t i = size_ - 1; i > idx; --i) {
-    arr_[i] = std::move_if_noexcept(arr_[i - 1]);
+}
+template <typename T, typename Allocator>
+template <typename U>
+constexpr void Vector<T, Allocator>::InsertIntoNewBuffer(std::size_t idx,
+                                                         U &&value) {
+  // Shifting could throw halfway, so build the result aside and keep the
+  // vector unchanged on failure.
+  std::size_t new_capacity = capacity_;
+  if (size_ == capacity_) {
+    new_capacity = capacity_ == 0 ? kDefaultCapacity : capacity_ * 2;
   }
-  arr_[idx] = std::forward<U>(value);
+  T *new_arr =
+      std::allocator_traits<Allocator>::allocate(allocator_, new_capacity);
+  try {
+    std::allocator_traits<Allocator>::construct(allocator_, new_arr + idx,
+                                                std::forward<U>(value));
+  } catch (...) {
+    std::allocator_traits<Allocator>::deallocate(allocator_, new_arr,
+                                                 new_capacity);
+    throw;
+  }
+  std::size_t built = 0;
+  try {
+    for (; built < size_; ++built) {
+      T *slot = new_arr + built + (built >= idx);
+      if constexpr (std::copy_constructible<T>) {
+        if (shared_ != nullptr) {
+          std::allocator_traits<Allocator>::construct(
+              allocator_, slot, std::as_const(arr_[built]));
+          continue;
+        }
+      }
+      std::allocator_traits<Allocator>::construct(
+          allocator_, slot, std::move_if_noexcept(arr_[built]));
+    }
+  } catch (...) {
+    for (std::size_t i = 0; i < built; ++i) {
+      std::allocator_traits<Allocator>::destroy(allocator_,
+                                                new_arr + i + (i >= idx));
+    }
+    std::allocator_traits<Allocator>::destroy(allocator_, new_arr + idx);
+    std::allocator_traits<Allocator>::deallocate(allocator_, new_arr,
+                                                 new_capacity);
+    throw;
+  }
+  ReleaseStorage();
+  arr_ = new_arr;
+  capacity_ = new_capacity;
   ++size_;
 }
 template <typename T, typename Allocator>
-void swap(Vector<T, Allocator> &a, Vector<T, Allocator> &b) {
+constexpr void swap(Vector<T, Allocator> &a, Vector<T, Allocator> &b) {
   a.Swap(b);
 }
+template <auto Build> consteval auto Freeze() {
+  using T = typename decltype(Build())::value_type;
+  constexpr std::size_t size = Build().Size();
+  std::array<T, size> table{};
+  auto vec = Build();
+  for (std::size_t i = 0; i < size; ++i) {
+    table[i] = vec[i];
+  }
+  return table;
+}
 }; // namespace vector
@@ -1,3 +1,5 @@
+#include <cstdint>
+
 #include <gtest/gtest.h>
 
 #include <allocators/dynamic_allocator.hpp>
@@ -85,3 +87,16 @@ TEST_F(VectorStruct, MovingVector) {
     EXPECT_EQ(v_moved[i], obj);
   }
 }
+TEST(DynamicMemoryResource, HonoursAlignmentAfterSplit) {
+  allocators::DynamicMemoryResource resource;
+  void *large = resource.allocate(200, 1);
+  resource.deallocate(large, 200, 1);
+  void *odd = resource.allocate(3, 1);
+  void *aligned = resource.allocate(64, 16);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(aligned) % 16, 0);
+  void *over_aligned = resource.allocate(64, 256);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(over_aligned) % 256, 0);
+  resource.deallocate(over_aligned, 64, 256);
+  resource.deallocate(aligned, 64, 16);
+  resource.deallocate(odd, 3, 1);
+}
@@ -1,5 +1,8 @@
 #include <allocators/dynamic_allocator.hpp>
 
+#include <cstdint>
+#include <iterator>
+
 namespace allocators {
 
 DynamicMemoryResource::DynamicMemoryResource() noexcept {}
@@ -14,20 +17,39 @@ DynamicMemoryResource::~DynamicMemoryResource() {
 }
 void *DynamicMemoryResource::do_allocate(std::size_t size, std::size_t alignment) {
   for (auto it = free_blocks_.begin(); it != free_blocks_.end(); ++it) {
-    if (it->size >= size) {
-      BlockData block = *it;
-      free_blocks_.erase(it);
-      if (block.size != size) {
-        free_blocks_.push_back({block.data + size, block.size - size});
-      }
-      occupied_blocks_.push_back({block.data, size});
-      return block.data;
+    void *ptr = TakeFromFreeBlock(it, size, alignment);
+    if (ptr != nullptr) {
+      return ptr;
     }
   }
-  BlockData new_block{new char[size], size};
+  std::size_t padding =
+      alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? alignment - 1 : 0;
+  BlockData new_block{new char[size + padding], size + padding};
   all_blocks_.push_back(new_block);
-  occupied_blocks_.push_back(new_block);
-  return new_block.data;
+  free_blocks_.push_back(new_block);
+  return TakeFromFreeBlock(std::prev(free_blocks_.end()), size, alignment);
+}
+void *DynamicMemoryResource::TakeFromFreeBlock(
+    std::list<BlockData>::iterator it, std::size_t size,
+    std::size_t alignment) {
+  // Split points of earlier blocks can be arbitrary, so round up the start
+  // and give the skipped head back to the free list.
+  std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(it->data);
+  std::size_t offset = (alignment - begin % alignment) % alignment;
+  if (it->size < offset + size) {
+    return nullptr;
+  }
+  BlockData block = *it;
+  free_blocks_.erase(it);
+  if (offset != 0) {
+    free_blocks_.push_back({block.data, offset});
+  }
+  if (block.size != offset + size) {
+    free_blocks_.push_back(
+        {block.data + offset + size, block.size - offset - size});
+  }
+  occupied_blocks_.push_back({block.data + offset, size});
+  return block.data + offset;
 }
 void DynamicMemoryResource::do_deallocate(void *ptr, std::size_t size,
                                      std::size_t alignment) {
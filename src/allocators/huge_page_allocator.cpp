@@ -0,0 +1,137 @@
+#include <allocators/huge_page_allocator.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#ifdef __linux__
+#include <linux/mman.h>
+#endif
+
+namespace allocators {
+namespace {
+std::size_t RoundUp(std::size_t size, std::size_t alignment) {
+  return (size + alignment - 1) / alignment * alignment;
+}
+// Asks for 2 MB hugetlb pages explicitly. A plain MAP_HUGETLB uses the
+// default pool size, which may be 1 GB, and then munmap of a 2 MB rounded
+// length fails with EINVAL.
+void *MapHugeTlb(std::size_t size) {
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_2MB)
+  void *ptr =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE,
+           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_HUGE_2MB, -1, 0);
+  if (ptr != MAP_FAILED) {
+    return ptr;
+  }
+#endif
+  return nullptr;
+}
+// Maps one extra huge page and trims both ends, so the kernel can back
+// the whole region with transparent huge pages.
+void *MapAligned(std::size_t size, bool transparent) {
+  std::size_t padded = size + HugePageMemoryResource::kHugePageSize;
+  void *ptr = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED) {
+    return nullptr;
+  }
+  std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(ptr);
+  std::uintptr_t aligned =
+      RoundUp(begin, HugePageMemoryResource::kHugePageSize);
+  std::size_t tail = begin + padded - (aligned + size);
+  if ((aligned != begin && munmap(ptr, aligned - begin) != 0) ||
+      (tail != 0 &&
+       munmap(reinterpret_cast<void *>(aligned + size), tail) != 0)) {
+    munmap(ptr, padded);
+    return nullptr;
+  }
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+  madvise(reinterpret_cast<void *>(aligned), size,
+          transparent ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#endif
+  return reinterpret_cast<void *>(aligned);
+}
+} // namespace
+
+HugePageMemoryResource::HugePageMemoryResource(
+    std::pmr::memory_resource *upstream, std::size_t threshold,
+    PageMode mode) noexcept
+    : upstream_(upstream), threshold_(threshold), mode_(mode) {}
+HugePageMemoryResource::HugePageMemoryResource(
+    HugePageMemoryResource &&resource) noexcept
+    : upstream_(resource.upstream_), threshold_(resource.threshold_),
+      mode_(resource.mode_),
+      mappings_(std::move(resource.mappings_)) {}
+HugePageMemoryResource::~HugePageMemoryResource() {
+  for (auto mapping : mappings_) {
+    [[maybe_unused]] int result = munmap(mapping.data, mapping.size);
+    assert(result == 0);
+  }
+}
+std::size_t HugePageMemoryResource::Threshold() const noexcept {
+  return threshold_;
+}
+std::size_t HugePageMemoryResource::MappedBytes() const noexcept {
+  std::size_t bytes = 0;
+  for (auto mapping : mappings_) {
+    bytes += mapping.size;
+  }
+  return bytes;
+}
+std::size_t HugePageMemoryResource::HugeTlbMappings() const noexcept {
+  std::size_t count = 0;
+  for (auto mapping : mappings_) {
+    count += mapping.hugetlb;
+  }
+  return count;
+}
+bool HugePageMemoryResource::IsLarge(std::size_t size,
+                                     std::size_t alignment) const noexcept {
+  return size >= threshold_ && size != 0 && alignment <= kHugePageSize;
+}
+void *HugePageMemoryResource::do_allocate(std::size_t size,
+                                          std::size_t alignment) {
+  if (!IsLarge(size, alignment)) {
+    return upstream_->allocate(size, alignment);
+  }
+  std::size_t mapped_size = RoundUp(size, kHugePageSize);
+  // Book the list node first, so a throwing push_back cannot leak a region.
+  mappings_.push_back({nullptr, mapped_size, false});
+  Mapping &mapping = mappings_.back();
+  if (mode_ == PageMode::kHugeTlb) {
+    mapping.data = MapHugeTlb(mapped_size);
+    mapping.hugetlb = mapping.data != nullptr;
+  }
+  if (mapping.data == nullptr) {
+    mapping.data = MapAligned(mapped_size, mode_ != PageMode::kNormal);
+  }
+  if (mapping.data == nullptr) {
+    mappings_.pop_back();
+    throw std::bad_alloc();
+  }
+  return mapping.data;
+}
+void HugePageMemoryResource::do_deallocate(void *ptr, std::size_t size,
+                                           std::size_t alignment) {
+  if (!IsLarge(size, alignment)) {
+    upstream_->deallocate(ptr, size, alignment);
+    return;
+  }
+  for (auto it = mappings_.begin(); it != mappings_.end(); ++it) {
+    if (it->data == ptr) {
+      // A region the kernel refused to unmap stays booked, so MappedBytes()
+      // keeps reporting it and the destructor tries again.
+      if (munmap(it->data, it->size) == 0) {
+        mappings_.erase(it);
+      }
+      return;
+    }
+  }
+}
+bool HugePageMemoryResource::do_is_equal(
+    const std::pmr::memory_resource &resource) const noexcept {
+  return this == &resource;
+}
+}; // namespace allocators
@@ -0,0 +1,63 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include <allocators/dynamic_allocator.hpp>
+#include <allocators/huge_page_allocator.hpp>
+#include <vector/vector.hpp>
+
+using allocators::HugePageMemoryResource;
+
+TEST(HugePageMemoryResource, SmallRequestsGoUpstream) {
+  allocators::DynamicMemoryResource upstream;
+  HugePageMemoryResource resource(&upstream);
+  void *ptr = resource.allocate(64, alignof(std::max_align_t));
+  EXPECT_EQ(resource.MappedBytes(), 0);
+  resource.deallocate(ptr, 64, alignof(std::max_align_t));
+}
+TEST(HugePageMemoryResource, LargeRequestsAreMappedAligned) {
+  HugePageMemoryResource resource;
+  std::size_t size = 3 * HugePageMemoryResource::kHugePageSize + 1;
+  void *ptr = resource.allocate(size, alignof(std::max_align_t));
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) %
+                HugePageMemoryResource::kHugePageSize,
+            0);
+  EXPECT_EQ(resource.MappedBytes(), 4 * HugePageMemoryResource::kHugePageSize);
+  resource.deallocate(ptr, size, alignof(std::max_align_t));
+  EXPECT_EQ(resource.MappedBytes(), 0);
+}
+TEST(HugePageMemoryResource, ThresholdIsConfigurable) {
+  HugePageMemoryResource resource(
+      std::pmr::new_delete_resource(), 4096,
+      HugePageMemoryResource::PageMode::kTransparent);
+  void *small = resource.allocate(4095, 8);
+  void *large = resource.allocate(4096, 8);
+  EXPECT_EQ(resource.MappedBytes(), HugePageMemoryResource::kHugePageSize);
+  EXPECT_EQ(resource.HugeTlbMappings(), 0);
+  resource.deallocate(small, 4095, 8);
+  resource.deallocate(large, 4096, 8);
+  EXPECT_EQ(resource.MappedBytes(), 0);
+}
+TEST(HugePageMemoryResource, BacksVectorGrowth) {
+  allocators::DynamicMemoryResource upstream;
+  HugePageMemoryResource resource(&upstream);
+  vector::Vector<std::uint64_t> v(0, &resource);
+  for (std::uint64_t i = 0; i < (1 << 20); ++i) {
+    v.PushBack(i);
+  }
+  EXPECT_GT(resource.MappedBytes(), 0);
+  std::uint64_t sum = 0;
+  for (auto it = v.CBegin(); it != v.CEnd(); ++it) {
+    sum += *it;
+  }
+  EXPECT_EQ(sum, (std::uint64_t{1} << 20) * ((1 << 20) - 1) / 2);
+}
+TEST(HugePageMemoryResource, NormalModeNeverUsesHugeTlb) {
+  HugePageMemoryResource resource(std::pmr::new_delete_resource(),
+                                  HugePageMemoryResource::kHugePageSize,
+                                  HugePageMemoryResource::PageMode::kNormal);
+  void *ptr = resource.allocate(HugePageMemoryResource::kHugePageSize, 8);
+  EXPECT_EQ(resource.MappedBytes(), HugePageMemoryResource::kHugePageSize);
+  EXPECT_EQ(resource.HugeTlbMappings(), 0);
+  resource.deallocate(ptr, HugePageMemoryResource::kHugePageSize, 8);
+}
@@ -0,0 +1,74 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+
+#include <allocators/huge_page_allocator.hpp>
+#include <vector/vector.hpp>
+
+// Scan throughput of a large Vector with and without huge pages.
+// Usage: huge_page_benchmark [buffer size in MB]
+// Configure with -DCMAKE_BUILD_TYPE=Release, the project-wide ASan flags
+// slow both runs alike, so compare the two lines rather than absolutes.
+namespace {
+using allocators::HugePageMemoryResource;
+using Clock = std::chrono::steady_clock;
+using Table = vector::Vector<std::uint64_t>;
+
+double Seconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+// Transparent huge pages backing the process in kB, -1 if unknown.
+long AnonHugePagesKb() {
+  const std::string field = "AnonHugePages:";
+  std::ifstream smaps("/proc/self/smaps_rollup");
+  std::string line;
+  while (std::getline(smaps, line)) {
+    if (line.compare(0, field.size(), field) == 0) {
+      return std::strtol(line.c_str() + field.size(), nullptr, 10);
+    }
+  }
+  return -1;
+}
+void Run(const char *name, HugePageMemoryResource::PageMode mode,
+         std::size_t count) {
+  HugePageMemoryResource resource(std::pmr::get_default_resource(),
+                                  HugePageMemoryResource::kHugePageSize, mode);
+  Table table(count, &resource);
+  for (std::size_t i = 0; i < count; ++i) {
+    table[i] = i * 2654435761u;
+  }
+  const Table &data = table;
+  std::size_t bytes = count * sizeof(std::uint64_t);
+  std::uint64_t sum = 0;
+  auto start = Clock::now();
+  for (int round = 0; round < 5; ++round) {
+    for (auto it = data.CBegin(); it != data.CEnd(); ++it) {
+      sum += *it;
+    }
+  }
+  double sequential = 5.0 * bytes / Seconds(start) / 1e9;
+  // Dependent random reads, one TLB lookup per element.
+  std::size_t idx = 0;
+  start = Clock::now();
+  for (std::size_t i = 0; i < count / 4; ++i) {
+    idx = (data[idx] ^ i) % count;
+    sum += idx;
+  }
+  double random = count / 4 / Seconds(start) / 1e6;
+  std::cout << name << ": sequential " << sequential << " GB/s, random "
+            << random << " M reads/s, hugetlb mappings "
+            << resource.HugeTlbMappings() << ", AnonHugePages "
+            << AnonHugePagesKb() << " kB (checksum " << sum << ")\n";
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 256;
+  std::size_t count = megabytes * 1024 * 1024 / sizeof(std::uint64_t);
+  Run("normal pages", HugePageMemoryResource::PageMode::kNormal, count);
+  Run("huge pages", HugePageMemoryResource::PageMode::kHugeTlb, count);
+}
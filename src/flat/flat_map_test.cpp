@@ -0,0 +1,158 @@
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <allocators/dynamic_allocator.hpp>
+#include <flat/flat_exceptions.hpp>
+#include <flat/flat_map.hpp>
+
+// Copying a negative value throws, so inserts can fail halfway.
+struct Fragile {
+  int value;
+  Fragile(int v) : value(v) {}
+  Fragile(const Fragile &other) : value(other.value) {
+    if (value < 0) {
+      throw std::runtime_error("fragile copy");
+    }
+  }
+  Fragile &operator=(const Fragile &other) {
+    if (other.value < 0) {
+      throw std::runtime_error("fragile assignment");
+    }
+    value = other.value;
+    return *this;
+  }
+};
+// Only assignment throws, which is what a shifting insert relies on.
+struct ThrowingAssignment {
+  int value;
+  ThrowingAssignment(int v) : value(v) {}
+  ThrowingAssignment(const ThrowingAssignment &other) = default;
+  ThrowingAssignment &operator=(const ThrowingAssignment &) {
+    throw std::runtime_error("assignment");
+  }
+};
+
+TEST(FlatMap, BulkConstructionKeepsFirstDuplicate) {
+  flat::FlatMap<int, std::string> map{{3, "c"}, {1, "a"}, {3, "x"}, {2, "b"}};
+  EXPECT_EQ(map.Size(), 3);
+  EXPECT_EQ(map.Keys()[0], 1);
+  EXPECT_EQ(map.Keys()[2], 3);
+  EXPECT_EQ(map.At(3), "c");
+  EXPECT_EQ(map.Values()[1], "b");
+}
+TEST(FlatMap, InsertFindErase) {
+  flat::FlatMap<std::string, int> map;
+  EXPECT_TRUE(map.Insert("one", 1));
+  EXPECT_TRUE(map.Insert("two", 2));
+  EXPECT_FALSE(map.Insert("one", 10));
+  EXPECT_EQ(map.At("one"), 1);
+  EXPECT_EQ(*map.Find("two"), 2);
+  EXPECT_EQ(map.Find("three"), nullptr);
+  EXPECT_THROW(map.At("three"), flat::KeyNotFound);
+  EXPECT_TRUE(map.Erase("one"));
+  EXPECT_FALSE(map.Contains("one"));
+  EXPECT_EQ(map.Size(), 1);
+}
+TEST(FlatMap, SubscriptInsertsDefault) {
+  flat::FlatMap<int, int> map;
+  map[5] += 2;
+  map[1] = 7;
+  map[5] += 3;
+  EXPECT_EQ(map.Size(), 2);
+  EXPECT_EQ(map.At(5), 5);
+  EXPECT_EQ(map.At(1), 7);
+}
+TEST(FlatMap, InsertRangeKeepsExistingValues) {
+  flat::FlatMap<int, int> map{{2, 20}, {4, 40}};
+  std::pair<int, int> added[] = {{4, -1}, {3, 30}, {1, 10}, {3, -1}};
+  map.InsertRange(added, added + 4);
+  ASSERT_EQ(map.Size(), 4);
+  for (int i = 1; i <= 4; ++i) {
+    EXPECT_EQ(map.Keys()[i - 1], i);
+    EXPECT_EQ(map.At(i), i * 10);
+  }
+}
+TEST(FlatMap, UsesMemoryResource) {
+  allocators::DynamicMemoryResource resource;
+  flat::FlatMap<int, double> map(&resource);
+  for (int i = 100; i > 0; --i) {
+    map.Insert(i, i / 2.0);
+  }
+  EXPECT_EQ(map.Size(), 100);
+  EXPECT_EQ(map.At(50), 25.0);
+  EXPECT_EQ(map.Keys().GetAllocator().resource(), &resource);
+  EXPECT_EQ(map.Values().GetAllocator().resource(), &resource);
+}
+TEST(FlatMap, EmptyMapDoesNotAllocate) {
+  flat::FlatMap<int, int> map(std::pmr::null_memory_resource());
+  EXPECT_EQ(map.Size(), 0);
+  EXPECT_FALSE(map.Contains(1));
+  EXPECT_EQ(map.Find(1), nullptr);
+}
+TEST(FlatMap, EytzingerIndexMatchesStdMap) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(0, 5000);
+  std::map<int, int> expected;
+  std::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 2000; ++i) {
+    int key = dist(gen);
+    expected.emplace(key, i);
+    pairs.emplace_back(key, i);
+  }
+  flat::FlatMap<int, int> map(pairs.begin(), pairs.end());
+  map.BuildEytzingerIndex();
+  EXPECT_EQ(map.Size(), expected.size());
+  for (int key = -1; key <= 5001; ++key) {
+    const int *value = map.Find(key);
+    auto it = expected.find(key);
+    if (it == expected.end()) {
+      EXPECT_EQ(value, nullptr);
+    } else {
+      ASSERT_NE(value, nullptr);
+      EXPECT_EQ(*value, it->second);
+    }
+  }
+}
+TEST(FlatMap, FailedInsertKeepsKeysAndValuesInStep) {
+  flat::FlatMap<int, Fragile> map;
+  map.Insert(1, Fragile(1));
+  map.Insert(3, Fragile(3));
+  map.Insert(4, Fragile(4));
+  EXPECT_THROW(map.Insert(2, Fragile(-2)), std::runtime_error);
+  EXPECT_EQ(map.Keys().Size(), 3);
+  EXPECT_EQ(map.Values().Size(), 3);
+  EXPECT_EQ(map.Find(2), nullptr);
+  EXPECT_EQ(map.At(3).value, 3);
+  EXPECT_EQ(map.At(4).value, 4);
+}
+TEST(FlatMap, InsertWithThrowingAssignment) {
+  flat::FlatMap<int, ThrowingAssignment> map;
+  map.Insert(1, ThrowingAssignment(1));
+  map.Insert(3, ThrowingAssignment(3));
+  map.Insert(2, ThrowingAssignment(2));
+  ASSERT_EQ(map.Values().Size(), 3);
+  for (int i = 1; i <= 3; ++i) {
+    EXPECT_EQ(map.At(i).value, i);
+  }
+}
+TEST(FlatMap, FailedInsertRangeKeepsMap) {
+  flat::FlatMap<std::string, Fragile> map;
+  map.Insert("b", Fragile(2));
+  map.Insert("d", Fragile(4));
+  // Copying this live value throws in the middle of the merge.
+  map.At("d").value = -4;
+  std::pair<std::string, Fragile> added[] = {{"a", Fragile(1)},
+                                             {"c", Fragile(3)}};
+  EXPECT_THROW(map.InsertRange(added, added + 2), std::runtime_error);
+  ASSERT_EQ(map.Size(), 2);
+  EXPECT_EQ(map.Keys()[0], "b");
+  EXPECT_EQ(map.Keys()[1], "d");
+  EXPECT_EQ(map.At("b").value, 2);
+  EXPECT_EQ(map.At("d").value, -4);
+}
@@ -0,0 +1,87 @@
+#include <random>
+#include <set>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <allocators/dynamic_allocator.hpp>
+#include <flat/flat_set.hpp>
+
+TEST(LowerBound, MatchesStd) {
+  int keys[] = {1, 3, 3, 5, 8, 13};
+  for (int key = 0; key < 15; ++key) {
+    std::size_t expected = std::lower_bound(keys, keys + 6, key) - keys;
+    EXPECT_EQ(flat::LowerBound(keys, 6, key, std::less<int>()), expected);
+  }
+  EXPECT_EQ(flat::LowerBound<int>(nullptr, 0, 1, std::less<int>()), 0);
+}
+TEST(FlatSet, BulkConstructionSortsAndDeduplicates) {
+  flat::FlatSet<int> set{5, 1, 4, 1, 3, 5};
+  EXPECT_EQ(set.Size(), 4);
+  EXPECT_EQ(set[0], 1);
+  EXPECT_EQ(set[1], 3);
+  EXPECT_EQ(set[2], 4);
+  EXPECT_EQ(set[3], 5);
+}
+TEST(FlatSet, InsertAndErase) {
+  flat::FlatSet<std::string> set;
+  EXPECT_TRUE(set.Insert("b"));
+  EXPECT_TRUE(set.Insert("a"));
+  EXPECT_TRUE(set.Insert("c"));
+  EXPECT_FALSE(set.Insert("a"));
+  EXPECT_EQ(set.Size(), 3);
+  EXPECT_TRUE(set.Contains("b"));
+  EXPECT_TRUE(set.Erase("b"));
+  EXPECT_FALSE(set.Erase("b"));
+  EXPECT_FALSE(set.Contains("b"));
+  EXPECT_EQ(*set.Find("c"), "c");
+  EXPECT_EQ(set.Find("d"), set.CEnd());
+  EXPECT_EQ(*set.LowerBound("b"), "c");
+}
+TEST(FlatSet, InsertRangeMerges) {
+  flat::FlatSet<int> set{2, 4, 6};
+  int added[] = {7, 1, 4, 5, 1};
+  set.InsertRange(added, added + 5);
+  int expected[] = {1, 2, 4, 5, 6, 7};
+  ASSERT_EQ(set.Size(), 6);
+  for (std::size_t i = 0; i < 6; ++i) {
+    EXPECT_EQ(set[i], expected[i]);
+  }
+}
+TEST(FlatSet, UsesMemoryResource) {
+  allocators::DynamicMemoryResource resource;
+  flat::FlatSet<int> set({3, 2, 1}, &resource);
+  set.Insert(0);
+  EXPECT_EQ(set.Size(), 4);
+  EXPECT_EQ(set[0], 0);
+  EXPECT_EQ(set.Keys().GetAllocator().resource(), &resource);
+}
+TEST(FlatSet, EmptySetDoesNotAllocate) {
+  flat::FlatSet<int> set(std::pmr::null_memory_resource());
+  EXPECT_EQ(set.Size(), 0);
+  EXPECT_FALSE(set.Contains(1));
+  EXPECT_EQ(set.Find(1), set.CEnd());
+}
+TEST(FlatSet, EytzingerIndexMatchesStdSet) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 10000);
+  std::set<int> expected;
+  flat::FlatSet<int> set;
+  for (int i = 0; i < 1000; ++i) {
+    int key = dist(gen);
+    expected.insert(key);
+    set.Insert(key);
+  }
+  set.BuildEytzingerIndex();
+  for (int key = -1; key <= 10001; ++key) {
+    EXPECT_EQ(set.Contains(key), expected.count(key) == 1);
+    auto it = expected.lower_bound(key);
+    if (it == expected.end()) {
+      EXPECT_EQ(set.LowerBound(key), set.CEnd());
+    } else {
+      EXPECT_EQ(*set.LowerBound(key), *it);
+    }
+  }
+  set.Insert(-5);
+  EXPECT_TRUE(set.Contains(-5));
+}
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include <vector/vector.hpp>
+
+template <typename T> using StdVector = vector::Vector<T, std::allocator<T>>;
+
+constexpr int SumAfterEdits() {
+  StdVector<int> v;
+  for (int i = 1; i <= 20; ++i) {
+    v.PushBack(i);
+  }
+  v.Insert(0, 100);
+  v.Delete(1);
+  v.Reserve(64);
+  int sum = 0;
+  for (auto it = v.CBegin(); it != v.CEnd(); ++it) {
+    sum += *it;
+  }
+  return sum;
+}
+static_assert(SumAfterEdits() == 100 + 209);
+
+constexpr bool CopiesAndMoves() {
+  StdVector<int> v{3, 1, 2};
+  StdVector<int> copy(v);
+  StdVector<int> moved(std::move(v));
+  copy = moved;
+  std::sort(copy.Begin(), copy.End());
+  return copy.Size() == 3 && copy[0] == 1 && copy.Back() == 3;
+}
+static_assert(CopiesAndMoves());
+
+constexpr auto kSquares = vector::Freeze<[] {
+  StdVector<int> v;
+  for (int i = 0; i < 16; ++i) {
+    v.PushBack(i * i);
+  }
+  return v;
+}>();
+static_assert(kSquares.size() == 16);
+static_assert(kSquares[15] == 225);
+
+TEST(ConstexprVector, FrozenTableIsStatic) {
+  static constexpr auto kTable = vector::Freeze<[] {
+    StdVector<char> v;
+    v.PushBack('b');
+    v.Insert(0, 'a');
+    return v;
+  }>();
+  EXPECT_EQ(kTable.size(), 2);
+  EXPECT_EQ(kTable[0], 'a');
+  EXPECT_EQ(kTable[1], 'b');
+  EXPECT_EQ(kSquares[4], 16);
+}
+TEST(ConstexprVector, WorksAtRuntime) {
+  EXPECT_EQ(SumAfterEdits(), 309);
+  EXPECT_TRUE(CopiesAndMoves());
+}
@@ -0,0 +1,196 @@
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include <allocators/dynamic_allocator.hpp>
+#include <vector/vector.hpp>
+
+struct CopyCounted {
+  static int copy_count;
+  int value;
+  CopyCounted(int v) : value(v) {}
+  CopyCounted(const CopyCounted &other) : value(other.value) { copy_count++; }
+  CopyCounted &operator=(const CopyCounted &other) {
+    value = other.value;
+    copy_count++;
+    return *this;
+  }
+};
+int CopyCounted::copy_count = 0;
+
+// Forwards to DynamicMemoryResource and records what was asked of it.
+class CheckingResource : public std::pmr::memory_resource {
+public:
+  int allocations = 0;
+  int misaligned = 0;
+
+private:
+  void *do_allocate(std::size_t size, std::size_t alignment) override {
+    void *ptr = upstream_.allocate(size, alignment);
+    ++allocations;
+    misaligned += reinterpret_cast<std::uintptr_t>(ptr) % alignment != 0;
+    return ptr;
+  }
+  void do_deallocate(void *ptr, std::size_t size,
+                     std::size_t alignment) override {
+    upstream_.deallocate(ptr, size, alignment);
+  }
+  bool do_is_equal(
+      const std::pmr::memory_resource &resource) const noexcept override {
+    return this == &resource;
+  }
+  allocators::DynamicMemoryResource upstream_;
+};
+
+TEST(Snapshot, ReadsSameElements) {
+  vector::Vector<int> v{1, 2, 3};
+  auto snapshot = v.TakeSnapshot();
+  EXPECT_EQ(snapshot.Size(), 3);
+  EXPECT_EQ(snapshot[0], 1);
+  EXPECT_EQ(snapshot.At(2), 3);
+  EXPECT_THROW(snapshot.At(3), vector::OutOfBounds);
+  EXPECT_EQ(snapshot.Front(), 1);
+  EXPECT_EQ(snapshot.Back(), 3);
+}
+TEST(Snapshot, TakingSnapshotDoesNotCopy) {
+  vector::Vector<CopyCounted> v;
+  for (int i = 0; i < 100; ++i) {
+    v.PushBack(CopyCounted(i));
+  }
+  CopyCounted::copy_count = 0;
+  auto snapshot = v.TakeSnapshot();
+  auto other = snapshot;
+  auto again = v.TakeSnapshot();
+  EXPECT_EQ(CopyCounted::copy_count, 0);
+  EXPECT_EQ(snapshot.Data(), other.Data());
+  EXPECT_EQ(snapshot.Data(), again.Data());
+}
+TEST(Snapshot, MutationForksBuffer) {
+  vector::Vector<int> v{1, 2, 3};
+  auto snapshot = v.TakeSnapshot();
+  v[0] = 10;
+  v.PushBack(4);
+  EXPECT_EQ(v.Size(), 4);
+  EXPECT_EQ(v[0], 10);
+  EXPECT_EQ(snapshot.Size(), 3);
+  EXPECT_EQ(snapshot[0], 1);
+  EXPECT_NE(snapshot.Data(), v.Data());
+}
+TEST(Snapshot, UniqueOwnerMutatesInPlace) {
+  vector::Vector<int> v{1, 2, 3};
+  const int *data = v.Data();
+  {
+    auto snapshot = v.TakeSnapshot();
+  }
+  v[1] = 20;
+  EXPECT_EQ(v.Data(), data);
+  EXPECT_EQ(v[1], 20);
+}
+TEST(Snapshot, VectorFromSnapshotForksLazily) {
+  vector::Vector<int> v{1, 2, 3};
+  auto snapshot = v.TakeSnapshot();
+  vector::Vector<int> writer(snapshot);
+  EXPECT_EQ(writer.Size(), 3);
+  writer.Insert(0, 0);
+  EXPECT_EQ(writer.Size(), 4);
+  EXPECT_EQ(writer[0], 0);
+  EXPECT_EQ(snapshot.Size(), 3);
+  EXPECT_EQ(snapshot[0], 1);
+  EXPECT_EQ(v[0], 1);
+}
+TEST(Snapshot, OutlivesVector) {
+  vector::Snapshot<std::string, std::pmr::polymorphic_allocator<std::string>>
+      snapshot;
+  EXPECT_EQ(snapshot.Size(), 0);
+  {
+    vector::Vector<std::string> v;
+    v.PushBack("hello");
+    v.PushBack("world");
+    snapshot = v.TakeSnapshot();
+  }
+  EXPECT_EQ(snapshot.Size(), 2);
+  EXPECT_EQ(snapshot[1], "world");
+  std::string joined;
+  for (auto it = snapshot.CBegin(); it != snapshot.CEnd(); ++it) {
+    joined += *it;
+  }
+  EXPECT_EQ(joined, "helloworld");
+}
+TEST(Snapshot, UsesVectorAllocator) {
+  CheckingResource resource;
+  vector::Vector<int> v(0, &resource);
+  for (int i = 0; i < 100; ++i) {
+    v.PushBack(i);
+  }
+  int before = resource.allocations;
+  auto snapshot = v.TakeSnapshot();
+  EXPECT_EQ(resource.allocations, before + 1);
+  v.PushBack(100);
+  EXPECT_EQ(resource.allocations, before + 2);
+  EXPECT_EQ(v.GetAllocator().resource(), &resource);
+  vector::Vector<int> writer(snapshot);
+  writer[0] = -1;
+  EXPECT_EQ(writer.GetAllocator().resource(), &resource);
+  EXPECT_EQ(resource.allocations, before + 3);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(snapshot[i], i);
+  }
+  EXPECT_EQ(v.Size(), 101);
+}
+TEST(Snapshot, HeaderIsAlignedAfterOddSplit) {
+  CheckingResource resource;
+  {
+    vector::Vector<char> large(200, &resource);
+  }
+  vector::Vector<char> small(3, &resource);
+  auto snapshot = small.TakeSnapshot();
+  EXPECT_EQ(resource.misaligned, 0);
+  EXPECT_EQ(snapshot.Size(), 3);
+}
+TEST(Snapshot, GrowingSharedVectorCopiesOnce) {
+  vector::Vector<CopyCounted> v;
+  for (int i = 0; i < 10; ++i) {
+    v.PushBack(CopyCounted(i));
+  }
+  ASSERT_EQ(v.Size(), v.Capacity());
+  auto snapshot = v.TakeSnapshot();
+  CopyCounted::copy_count = 0;
+  v.PushBack(CopyCounted(10));
+  EXPECT_EQ(CopyCounted::copy_count, 11);
+  EXPECT_EQ(snapshot.Size(), 10);
+}
+TEST(Snapshot, InsertIntoFullSharedVectorCopiesOnce) {
+  vector::Vector<CopyCounted> v;
+  for (int i = 0; i < 10; ++i) {
+    v.PushBack(CopyCounted(i));
+  }
+  ASSERT_EQ(v.Size(), v.Capacity());
+  auto snapshot = v.TakeSnapshot();
+  CopyCounted::copy_count = 0;
+  v.Insert(10, CopyCounted(10));
+  EXPECT_EQ(CopyCounted::copy_count, 11);
+  EXPECT_EQ(snapshot.Size(), 10);
+}
+TEST(Snapshot, ConcurrentReaders) {
+  vector::Vector<int> v;
+  for (int i = 0; i < 1000; ++i) {
+    v.PushBack(i);
+  }
+  auto snapshot = v.TakeSnapshot();
+  std::thread reader([snapshot]() {
+    long long sum = 0;
+    for (int round = 0; round < 100; ++round) {
+      for (auto it = snapshot.CBegin(); it != snapshot.CEnd(); ++it) {
+        sum += *it;
+      }
+    }
+    EXPECT_EQ(sum, 100LL * 999 * 1000 / 2);
+  });
+  for (int i = 0; i < 1000; ++i) {
+    v[i] = -1;
+  }
+  reader.join();
+  EXPECT_EQ(snapshot[999], 999);
+}
@@ -1,3 +1,4 @@
+#include <stdexcept>
 #include <string>
 
 #include <gtest/gtest.h>
@@ -236,6 +237,43 @@ TEST_F(VectorTest, Insert) {
   EXPECT_EQ(vec[5], 5);
 }
 
+TEST_F(VectorTest, InsertIntoEmpty) {
+  vector::Vector<std::string> vec(
+      std::pmr::polymorphic_allocator<std::string>{});
+  vec.Insert(0, "b");
+  vec.Insert(0, "a");
+  EXPECT_EQ(vec.Size(), 2);
+  EXPECT_EQ(vec[0], "a");
+  EXPECT_EQ(vec[1], "b");
+}
+
+TEST_F(VectorTest, FailedInsertLeavesVectorUnchanged) {
+  struct Throwing {
+    int value;
+    Throwing(int v) : value(v) {}
+    Throwing(const Throwing &other) : value(other.value) {
+      if (value < 0) {
+        throw std::runtime_error("copy");
+      }
+    }
+    Throwing &operator=(const Throwing &) = default;
+  };
+  vector::Vector<Throwing> throwing{Throwing(1), Throwing(2), Throwing(3)};
+  throwing[2].value = -3;
+  EXPECT_THROW(throwing.Insert(0, Throwing(0)), std::runtime_error);
+  ASSERT_EQ(throwing.Size(), 3);
+  EXPECT_EQ(throwing[0].value, 1);
+  EXPECT_EQ(throwing[1].value, 2);
+  EXPECT_EQ(throwing[2].value, -3);
+}
+
+TEST_F(VectorTest, InsertOwnElement) {
+  vector::Vector<TrackedType> vec{1, 2, 3};
+  vec.Insert(1, vec[2]);
+  EXPECT_EQ(vec.Size(), 4);
+  EXPECT_EQ(vec[1].value, 3);
+}
+
 TEST_F(VectorTest, Reserve) {
   vector::Vector<int> vec{1, 2, 3};
   vec.Reserve(10);